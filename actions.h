@@ -6,6 +6,11 @@
 #include <QKeySequence>
 #include <QShortcut>
 #include <QCursor>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QPointer>
+#include <QThreadPool>
 
 // ----- out-of-class definitions for ColFM -----
 
@@ -28,6 +33,7 @@ inline void ColFM::drawButtons() {
     treeBtn       = tb->addAction(QIcon("icons/view_tree.png"),     "Tree/List View");      treeBtn->setToolTip("Switch to Tree/List view");
     columnBtn     = tb->addAction(QIcon("icons/view_columns.png"),  "Column View");         columnBtn->setToolTip("Switch to Column view");
     iconBtn       = tb->addAction(QIcon("icons/view_icons.png"),    "Icon View");           iconBtn->setToolTip("Switch to Icon view");
+    usageBtn      = tb->addAction(QIcon("icons/view_usage.png"),    "Usage View");          usageBtn->setToolTip("Switch to disk usage map");
 
     toggleHiddenBtn = tb->addAction(QIcon("icons/eye-slash.png"),   "Show/Hide Invisibles");
     toggleHiddenBtn->setToolTip("Toggle hidden files");
@@ -51,6 +57,7 @@ inline void ColFM::drawButtons() {
     connect(treeBtn,        &QAction::triggered, this, &ColFM::onViewTree);
     connect(columnBtn,      &QAction::triggered, this, &ColFM::onViewColumn);
     connect(iconBtn,        &QAction::triggered, this, &ColFM::onViewIcon);
+    connect(usageBtn,       &QAction::triggered, this, &ColFM::onViewUsage);
 
     // Global shortcuts (no event filter)
     actInfo->setShortcuts({ QKeySequence(Qt::CTRL | Qt::Key_I), QKeySequence(Qt::Key_Space) });
@@ -63,12 +70,32 @@ inline void ColFM::drawButtons() {
     auto scSpace = new QShortcut(QKeySequence(Qt::Key_Space), this);
     scSpace->setContext(Qt::ApplicationShortcut);
     connect(scSpace, &QShortcut::activated, this, &ColFM::onInfo);
+
+    // Window-only so it can't re-trigger from inside the (modal) jump dialog
+    auto scJump = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_P), this);
+    scJump->setContext(Qt::WindowShortcut);
+    connect(scJump, &QShortcut::activated, this, &ColFM::onJump);
 }
 
-inline void ColFM::onMoveToTrash()            { statusBar()->showMessage("TODO: Move to Trash", 2000); }
+inline void ColFM::onMoveToTrash() {
+    const QStringList srcs = selectedPaths();
+    if (srcs.isEmpty()) { statusBar()->showMessage("Nothing selected", 2000); return; }
+    const QString what = srcs.size() == 1 ? QString("\"%1\"").arg(QFileInfo(srcs.first()).fileName())
+                                          : QString("%1 items").arg(srcs.size());
+    if (QMessageBox::question(this, "Move to Trash", QString("Move %1 to the Trash?").arg(what)) != QMessageBox::Yes) return;
+
+    QStringList errors;
+    for (const QString &src : srcs) {
+        QString err;
+        if (!trashPath(src, &err)) errors << err;
+    }
+    if (errors.isEmpty()) statusBar()->showMessage("Moved to Trash", 1500);
+    else statusBar()->showMessage(errors.first(), 3000);
+}
 inline void ColFM::onRefresh() {
     const QString path = model->filePath(currentRoot);
     model->setRootPath(path);
+    if (usageView) { usageView->deleteLater(); usageView = nullptr; } // rescan on next Usage view
     setViewMode(mode);
     statusBar()->showMessage("Folder refreshed", 1500);
 }
@@ -107,23 +134,60 @@ inline void ColFM::onInfo() {
 }
 
 inline void ColFM::onRename()                 { statusBar()->showMessage("TODO: Rename", 2000); }
-inline void ColFM::onMove()                   { statusBar()->showMessage("TODO: Move", 2000); }
-inline void ColFM::onDuplicate()              { statusBar()->showMessage("TODO: Duplicate", 2000); }
+inline void ColFM::onMove() {
+    const QStringList srcs = selectedPaths();
+    if (srcs.isEmpty()) { statusBar()->showMessage("Nothing selected", 2000); return; }
+    const QString dir = QFileDialog::getExistingDirectory(this, "Move to", QFileInfo(srcs.first()).absolutePath());
+    if (dir.isEmpty()) return;
+    QStringList targets;
+    for (const QString &src : srcs) targets << dir + "/" + QFileInfo(src).fileName();
+    runTransfer(true, srcs, targets);
+}
+inline void ColFM::onDuplicate() {
+    const QStringList srcs = selectedPaths();
+    if (srcs.isEmpty()) { statusBar()->showMessage("Nothing selected", 2000); return; }
+    runTransfer(false, srcs, QStringList()); // names are picked next to each source when the copy starts
+}
+
+// Copies and cross-filesystem moves can take minutes, so they run on the global pool
+// and only the summary comes back to the status bar
+inline void ColFM::runTransfer(bool move, const QStringList &sources, const QStringList &targets) {
+    statusBar()->showMessage(QString("%1 %2 item(s)…").arg(move ? "Moving" : "Duplicating").arg(sources.size()));
+    QPointer<ColFM> self(this);
+    QThreadPool::globalInstance()->start([self, move, sources, targets]{
+        QStringList errors;
+        for (int i = 0; i < sources.size(); ++i) {
+            const QString target = targets.isEmpty() ? uniqueCopyName(sources[i]) : targets[i];
+            QString err;
+            if (!(move ? movePath(sources[i], target, &err) : copyPath(sources[i], target, &err))) errors << err;
+        }
+        QMetaObject::invokeMethod(qApp, [self, move, n = sources.size(), errors]{
+            if (!self) return; // window closed meanwhile
+            if (errors.isEmpty())
+                self->statusBar()->showMessage(QString("%1 %2 item(s)").arg(move ? "Moved" : "Duplicated").arg(n), 1500);
+            else
+                self->statusBar()->showMessage(errors.size() == 1 ? errors.first()
+                                               : QString("%1 (and %2 more errors)").arg(errors.first()).arg(errors.size() - 1), 5000);
+        }, Qt::QueuedConnection);
+    });
+}
 inline void ColFM::onCreateSoftlink()         { statusBar()->showMessage("TODO: Create Softlink", 2000); }
 
 inline void ColFM::onToggleHidden() {
     showHidden = !showHidden;
-    QDir::Filters f = QDir::AllEntries | QDir::NoDotAndDotDot;
-    if (showHidden) {
-        f |= QDir::Hidden;
-        toggleHiddenBtn->setIcon(QIcon("icons/eye.png"));
-    } else {
-        toggleHiddenBtn->setIcon(QIcon("icons/eye-slash.png"));
-    }
-    model->setFilter(f);
+    toggleHiddenBtn->setIcon(QIcon(showHidden ? "icons/eye.png" : "icons/eye-slash.png"));
+    model->setFilter(listingFilter(showHidden));
     setViewMode(mode);
 }
 
+inline void ColFM::onJump() {
+    JumpDialog dlg(paths, this);
+    if (dlg.exec() != QDialog::Accepted) return;
+    const QString p = dlg.chosenPath();
+    if (!p.isEmpty()) goTo(p);
+}
+
 inline void ColFM::onViewTree()   { setViewMode(ViewMode::Tree); }
 inline void ColFM::onViewColumn() { setViewMode(ViewMode::Column); }
 inline void ColFM::onViewIcon()   { setViewMode(ViewMode::Icon); }
+inline void ColFM::onViewUsage()  { setViewMode(ViewMode::Usage); }
@@ -0,0 +1,407 @@
+// colfm-cli: headless front end to the ColFM engines (QtCore only, no X server needed)
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <QMutex>
+#include <cstdio>
+
+#include "fscore.h"    // listing, usage tree, duplicates, copy/move/trash
+#include "pathindex.h" // fuzzy scorer for find --fuzzy
+
+static QTextStream out(stdout);
+static QTextStream err(stderr);
+
+// Machine-readable progress: one compact JSON object per line on stderr
+class Progress {
+public:
+    explicit Progress(bool on) : on(on) {}
+    bool enabled() const { return on; }
+    void report(const QJsonObject &o) const {
+        if (!on) return;
+        err << QJsonDocument(o).toJson(QJsonDocument::Compact) << '\n';
+        err.flush();
+    }
+private:
+    bool on;
+};
+
+// Commands only offer -j/--jobs and --progress when they would act on them
+static void addCommonOptions(QCommandLineParser &p, bool jobs = true, bool progress = true) {
+    p.addHelpOption();
+    p.addOption({"json", "Print results as JSON."});
+    if (jobs) p.addOption({{"j", "jobs"}, "Worker threads (default: one per core; folder scans use 2 to 8).", "N"});
+    if (progress) p.addOption({"progress", "Report progress as JSON lines on stderr."});
+}
+
+static int jobsOf(const QCommandLineParser &p) {
+    return p.isSet("jobs") ? qMax(1, p.value("jobs").toInt()) : 0;
+}
+
+static void printJson(const QJsonArray &arr) {
+    out << QJsonDocument(arr).toJson(QJsonDocument::Indented);
+    out.flush();
+}
+
+static void fail(const QString &cmd, const QString &msg) {
+    err << "colfm-cli: " << cmd << ": " << msg << '\n';
+    err.flush();
+}
+
+// ---- Scanning (same engine as the Usage view) ----
+
+static QJsonObject scanStatus(const UsageTree &t, const QString &op, bool done) {
+    return QJsonObject{
+        { "op", op }, { "path", t.root()->path() }, { "done", done },
+        { "dirs", t.dirs() }, { "files", t.files() }, { "bytes", t.root()->size }, { "queued", t.pendingDirs() },
+    };
+}
+
+static std::unique_ptr<UsageTree> scanTree(const QString &path, int jobs, const Progress &progress, const QString &op) {
+    auto tree = std::make_unique<UsageTree>(path, jobs);
+    QEventLoop loop;
+    tree->setOnFinished([&loop]{ loop.quit(); });
+
+    QTimer tick;
+    QObject::connect(&tick, &QTimer::timeout, [&]{ progress.report(scanStatus(*tree, op, false)); });
+    if (progress.enabled()) tick.start(200);
+
+    tree->start();
+    if (!tree->finished()) loop.exec();
+    tree->setOnFinished(nullptr);
+    progress.report(scanStatus(*tree, op, true));
+    return tree;
+}
+
+static std::vector<const UsageNode*> sortedChildren(const UsageNode *n) {
+    std::vector<const UsageNode*> kids;
+    for (const auto &c : n->children) kids.push_back(c.get());
+    std::sort(kids.begin(), kids.end(), [](const UsageNode *a, const UsageNode *b){ return a->name < b->name; });
+    return kids;
+}
+
+// ---- Commands ----
+
+static int cmdLs(const QStringList &args) {
+    QCommandLineParser p;
+    p.setApplicationDescription("List folders the way the GUI shows them (dotfiles hidden unless -a).");
+    addCommonOptions(p, false, false);
+    p.addOption({{"a", "all"}, "Include hidden entries."});
+    p.addPositionalArgument("path", "Folders or files to list (default: current folder).", "[path...]");
+    p.process(args);
+
+    QStringList paths = p.positionalArguments();
+    if (paths.isEmpty()) paths << ".";
+    const bool json = p.isSet("json");
+
+    int rc = 0;
+    QJsonArray arr;
+    for (const QString &path : paths) {
+        const QFileInfo fi(path);
+        if (!fi.exists()) { fail("ls", path + ": not found"); rc = 1; continue; }
+        const QFileInfoList items = fi.isDir() ? listFolder(path, p.isSet("all")) : QFileInfoList{ fi };
+        if (!json && paths.size() > 1) out << path << ":\n";
+        for (const QFileInfo &item : items) {
+            if (json) { arr.append(fileInfoJson(item)); continue; }
+            out << permsToString(item.permissions()) << "  "
+                << QString(item.isDir() ? "-" : humanSize(item.size())).rightJustified(9) << "  "
+                << item.lastModified().toString(Qt::ISODate) << "  "
+                << item.fileName() << (item.isDir() ? "/" : "") << '\n';
+        }
+    }
+    if (json) printJson(arr);
+    out.flush();
+    return rc;
+}
+
+static int cmdDu(const QStringList &args) {
+    QCommandLineParser p;
+    p.setApplicationDescription("Folder sizes, as the Usage view computes them. Sizes are apparent sizes "
+                                "(file lengths), not allocated blocks; a hard-linked file counts once. Unlike du -b, "
+                                "folders themselves add nothing, so totals come out smaller. "
+                                "Symlinks are not followed and other filesystems are not entered (like du -x).");
+    addCommonOptions(p);
+    p.addOption({{"d", "max-depth"}, "Only print folders up to N levels below each path.", "N"});
+    p.addOption({"human", "Sizes as the GUI prints them (KB, MB, …) instead of bytes."});
+    p.addPositionalArgument("path", "Folders to measure (default: current folder).", "[path...]");
+    p.process(args);
+
+    QStringList paths = p.positionalArguments();
+    if (paths.isEmpty()) paths << ".";
+    const bool json = p.isSet("json"), human = p.isSet("human");
+    const int maxDepth = p.isSet("max-depth") ? p.value("max-depth").toInt() : -1;
+    const Progress progress(p.isSet("progress"));
+
+    int rc = 0;
+    QJsonArray arr;
+    auto print = [&](const QString &path, qint64 size){
+        if (json) arr.append(QJsonObject{ { "path", path }, { "size", size } });
+        else out << (human ? humanSize(size) : QString::number(size)) << '\t' << path << '\n';
+    };
+
+    for (const QString &path : paths) {
+        const QFileInfo fi(path);
+        if (!fi.exists()) { fail("du", path + ": not found"); rc = 1; continue; }
+        if (!fi.isDir()) { print(fi.absoluteFilePath(), fi.size()); continue; }
+
+        auto tree = scanTree(path, jobsOf(p), progress, "du");
+        // Children before parents, like du
+        std::function<void(const UsageNode*, int)> walk = [&](const UsageNode *n, int depth){
+            if (maxDepth < 0 || depth < maxDepth)
+                for (const UsageNode *c : sortedChildren(n))
+                    if (c->isDir && !c->otherDevice) walk(c, depth + 1);
+            print(n->path(), n->size);
+        };
+        walk(tree->root(), 0);
+    }
+    if (json) printJson(arr);
+    out.flush();
+    return rc;
+}
+
+static int cmdFind(const QStringList &args) {
+    QCommandLineParser p;
+    p.setApplicationDescription("Find files and folders by name glob, or rank them with the GUI's fuzzy matcher.");
+    addCommonOptions(p);
+    p.addOption({"name", "Match names against a glob (case-sensitive).", "glob"});
+    p.addOption({"iname", "Match names against a glob (case-insensitive).", "glob"});
+    p.addOption({"fuzzy", "Rank full paths against a fuzzy query, best first.", "query"});
+    p.addOption({"limit", "Results for --fuzzy (default 50).", "K", "50"});
+    p.addOption({"type", "Only files (f) or folders (d).", "f|d"});
+    p.addPositionalArgument("path", "Folders to search (default: current folder).", "[path...]");
+    p.process(args);
+
+    QStringList paths = p.positionalArguments();
+    if (paths.isEmpty()) paths << ".";
+    const bool json = p.isSet("json");
+    const QString type = p.value("type");
+    if (!type.isEmpty() && type != "f" && type != "d") { fail("find", "--type must be f or d"); return 2; }
+    const Progress progress(p.isSet("progress"));
+
+    const bool glob = p.isSet("name") || p.isSet("iname");
+    const QRegularExpression re(glob ? QRegularExpression::wildcardToRegularExpression(p.isSet("name") ? p.value("name") : p.value("iname"))
+                                     : QString(),
+                                p.isSet("iname") ? QRegularExpression::CaseInsensitiveOption : QRegularExpression::NoPatternOption);
+
+    int rc = 0;
+    std::vector<std::unique_ptr<UsageTree>> trees;
+    std::vector<const UsageNode*> hits;
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) { fail("find", path + ": not a folder"); rc = 1; continue; }
+        trees.push_back(scanTree(path, jobsOf(p), progress, "find"));
+        std::function<void(const UsageNode*)> walk = [&](const UsageNode *n){
+            const bool typeOk = type.isEmpty() || (type == "d") == n->isDir;
+            const QString name = n->parent ? n->name : QFileInfo(n->name).fileName();
+            if (typeOk && (!glob || re.match(name).hasMatch())) hits.push_back(n);
+            for (const UsageNode *c : sortedChildren(n)) walk(c);
+        };
+        walk(trees.back()->root());
+    }
+
+    QStringList results;
+    if (p.isSet("fuzzy")) {
+        std::vector<FuzzyCandidate> cands;
+        cands.reserve(hits.size());
+        for (const UsageNode *n : hits) cands.push_back(makeFuzzyCandidate(n->path()));
+        results = fuzzyTopK(cands, p.value("fuzzy"), qMax(1, p.value("limit").toInt()));
+    } else {
+        for (const UsageNode *n : hits) results << n->path();
+    }
+
+    if (json) {
+        QJsonArray arr;
+        for (const QString &r : results) arr.append(fileInfoJson(QFileInfo(r)));
+        printJson(arr);
+    } else {
+        for (const QString &r : results) out << r << '\n';
+    }
+    out.flush();
+    return rc;
+}
+
+static int cmdDupes(const QStringList &args) {
+    QCommandLineParser p;
+    p.setApplicationDescription("Groups of identical files (size, then SHA-256), most wasted space first.");
+    addCommonOptions(p);
+    p.addOption({"min-size", "Ignore files smaller than this many bytes (default 1).", "bytes", "1"});
+    p.addPositionalArgument("path", "Folders to search (default: current folder).", "[path...]");
+    p.process(args);
+
+    QStringList paths = p.positionalArguments();
+    if (paths.isEmpty()) paths << ".";
+    const Progress progress(p.isSet("progress"));
+
+    int rc = 0;
+    QVector<FileSize> files;  // overlapping paths are dropped by inode in findDuplicates
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) { fail("dupes", path + ": not a folder"); rc = 1; continue; }
+        auto tree = scanTree(path, jobsOf(p), progress, "dupes");
+        collectFiles(tree->root(), files);
+    }
+
+    QThreadPool pool;
+    if (jobsOf(p) > 0) pool.setMaxThreadCount(jobsOf(p));
+    const auto groups = findDuplicates(files, p.value("min-size").toLongLong(), &pool,
+        [&progress](int hashed, int total){
+            progress.report(QJsonObject{ { "op", "dupes" }, { "hashed", hashed }, { "total", total } });
+        });
+
+    QHash<QString, qint64> sizeOf;
+    for (const FileSize &f : files) sizeOf.insert(f.path, f.size);
+
+    if (p.isSet("json")) {
+        QJsonArray arr;
+        for (const QStringList &g : groups)
+            arr.append(QJsonObject{ { "size", sizeOf.value(g.first()) }, { "paths", QJsonArray::fromStringList(g) } });
+        printJson(arr);
+    } else {
+        for (const QStringList &g : groups) {
+            out << sizeOf.value(g.first()) << " bytes each:\n";
+            for (const QString &path : g) out << path << '\n';
+            out << '\n';
+        }
+    }
+    out.flush();
+    return rc;
+}
+
+// cp and mv: each source runs as one task on the pool
+static int transfer(const QString &cmd, const QStringList &args) {
+    const bool move = cmd == "mv";
+    QCommandLineParser p;
+    p.setApplicationDescription(move ? "Move files and folders (rename, or copy + delete across filesystems)."
+                                     : "Copy files and folders recursively; never overwrites.");
+    addCommonOptions(p);
+    p.addPositionalArgument("source", "Files or folders.", "source...");
+    p.addPositionalArgument("dest", "Target folder, or the new name for a single source.");
+    p.process(args);
+
+    QStringList sources = p.positionalArguments();
+    if (sources.size() < 2) { fail(cmd, "need at least one source and a destination"); return 2; }
+    const QString dest = sources.takeLast();
+    const bool intoDir = QFileInfo(dest).isDir();
+    if (!intoDir && sources.size() > 1) { fail(cmd, dest + ": not a folder"); return 2; }
+    const Progress progress(p.isSet("progress"));
+
+    QThreadPool pool;
+    if (jobsOf(p) > 0) pool.setMaxThreadCount(jobsOf(p));
+    std::atomic<int> finished{0};
+    std::atomic<qint64> copiedFiles{0}, copiedBytes{0};
+    QMutex lock;
+    QVector<QJsonObject> results(sources.size());   // one slot per source, printed in argument order
+    int failures = 0;
+
+    // Sources that land on the same target ("a/x b/x dest/") share one task and run in argument
+    // order, so the second fails on "already exists" instead of merging into the first
+    QStringList targets;
+    QHash<QString, QVector<int>> byTarget;
+    for (int i = 0; i < sources.size(); ++i) {
+        // "dir/" (as tab completion writes it) has an empty fileName() until cleaned
+        targets << (intoDir ? QDir::cleanPath(dest + "/" + QFileInfo(QDir::cleanPath(sources[i])).fileName()) : dest);
+        byTarget[targets[i]] << i;
+    }
+
+    for (int first = 0; first < sources.size(); ++first) {
+        const QVector<int> group = byTarget.value(targets[first]);
+        if (group.first() != first) continue;
+        pool.start([&, group]{
+            for (int i : group) {
+                const QString &src = sources.at(i), &target = targets.at(i);
+                auto onFile = [&](qint64 bytes){ ++copiedFiles; copiedBytes += bytes; };
+                QString error;
+                const bool ok = move ? movePath(src, target, &error, onFile) : copyPath(src, target, &error, onFile);
+                ++finished;
+                QMutexLocker locker(&lock);
+                QJsonObject r{ { "source", src }, { "target", target }, { "ok", ok } };
+                if (!ok) { r["error"] = error; ++failures; fail(cmd, error); }
+                results[i] = r;
+            }
+        });
+    }
+
+    auto status = [&](bool done){
+        return QJsonObject{ { "op", cmd }, { "done", done }, { "finished", finished.load() }, { "total", qint64(sources.size()) },
+                            { "files", copiedFiles.load() }, { "bytes", copiedBytes.load() } };
+    };
+    // Workers print errors under the same lock, so stderr lines never interleave
+    while (!pool.waitForDone(200)) {
+        QMutexLocker locker(&lock);
+        progress.report(status(false));
+    }
+    progress.report(status(true));
+
+    if (p.isSet("json")) {
+        QJsonArray arr;
+        for (const QJsonObject &r : results) arr.append(r);
+        printJson(arr);
+    }
+    return failures ? 1 : 0;
+}
+
+static int cmdTrash(const QStringList &args) {
+    QCommandLineParser p;
+    p.setApplicationDescription("Move to the desktop Trash (the folder the GUI's Open Trash shows), one item at a time.");
+    addCommonOptions(p, false);
+    p.addPositionalArgument("path", "Files or folders.", "path...");
+    p.process(args);
+
+    const QStringList paths = p.positionalArguments();
+    if (paths.isEmpty()) { fail("trash", "nothing to trash"); return 2; }
+    const Progress progress(p.isSet("progress"));
+
+    int failures = 0, finished = 0;
+    QJsonArray results;
+    for (const QString &path : paths) {
+        QString error;
+        const bool ok = trashPath(path, &error);
+        QJsonObject r{ { "path", path }, { "ok", ok } };
+        if (!ok) { r["error"] = error; ++failures; fail("trash", error); }
+        results.append(r);
+        progress.report(QJsonObject{ { "op", "trash" }, { "done", ++finished == paths.size() },
+                                     { "finished", finished }, { "total", qint64(paths.size()) } });
+    }
+    if (p.isSet("json")) printJson(results);
+    return failures ? 1 : 0;
+}
+
+static void usage() {
+    out << "usage: colfm-cli <command> [options] [args]\n\n"
+           "commands:\n"
+           "  ls      list folders (--json, -a)\n"
+           "  du      folder sizes (-d N, --human)\n"
+           "  find    find by --name/--iname glob or --fuzzy query\n"
+           "  dupes   identical files\n"
+           "  cp      copy files and folders\n"
+           "  mv      move files and folders\n"
+           "  trash   move to Trash\n\n"
+           "Common options: --json; all but ls: --progress (JSON lines on stderr);\n"
+           "du, find, dupes, cp, mv: -j/--jobs N.\n"
+           "Run 'colfm-cli <command> --help' for details.\n";
+    out.flush();
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("colfm-cli");
+
+    QStringList args = app.arguments();
+    const QString cmd = args.value(1);
+    if (args.size() > 1) args.removeAt(1);
+    args[0] = "colfm-cli " + cmd;
+
+    if (cmd == "ls")    return cmdLs(args);
+    if (cmd == "du")    return cmdDu(args);
+    if (cmd == "find")  return cmdFind(args);
+    if (cmd == "dupes") return cmdDupes(args);
+    if (cmd == "cp" || cmd == "mv") return transfer(cmd, args);
+    if (cmd == "trash") return cmdTrash(args);
+
+    usage();
+    return (cmd == "help" || cmd == "--help" || cmd == "-h") ? 0 : 2;
+}
@@ -24,12 +24,16 @@
 #include <QStatusBar>
 #include <QCursor>
 
+#include "fscore.h" // GUI-free engines shared with colfm-cli
 #include "toolbars.h" // Breadcrumbs class
+#include "usagemap.h" // Usage (treemap) view
+#include "pathindex.h" // frecency + fuzzy folder matching
+#include "jumpdialog.h" // Ctrl+P Go to Folder
 
 // -------- Settings --------
 static const QSize kIconSize(32, 32);
 
-enum class ViewMode { Tree, Column, Icon };
+enum class ViewMode { Tree, Column, Icon, Usage };
 
 // Force app-wide 32 px icon metrics
 class ForceIconStyle : public QProxyStyle {
@@ -137,8 +141,9 @@ public:
     ColFM(QWidget *parent=nullptr) : QMainWindow(parent) {
         model = new FixedFSModel(this);
         model->setIconProvider(new CustomIconProvider());
-        model->setFilter(QDir::AllEntries | QDir::NoDotAndDotDot); // dotfiles hidden by default
+        model->setFilter(listingFilter(false)); // dotfiles hidden by default
         currentRoot = model->setRootPath(QDir::homePath());
+        paths = new PathIndex(this);
 
         // Main toolbar FIRST (fixed row)
         tb = new QToolBar("Main Toolbar", this);
@@ -152,14 +157,8 @@ public:
         // Path bar SECOND row (editable current path)
         crumbs = new Breadcrumbs("Path", this);
         addToolBar(Qt::TopToolBarArea, crumbs);
-        crumbs->setOnPathChosen([this](const QString &p){
-            if (QDir(p).exists()) {
-                currentRoot = model->index(p);
-                setViewMode(mode);
-            } else {
-                statusBar()->showMessage("Path not found", 2000);
-            }
-        });
+        crumbs->setOnPathChosen([this](const QString &p){ goTo(p); });
+        crumbs->setCompletionIndex(paths);
         crumbs->setPath(model->filePath(currentRoot));
 
         setViewMode(ViewMode::Tree);
@@ -176,14 +175,16 @@ private:
     QModelIndex currentRoot;
     QLabel *previewLabel{};
     bool showHidden = false;
+    PathIndex *paths{}; // visited folders for completion and Go to Folder
 
     // UI
     Breadcrumbs *crumbs{};
     QToolBar *tb{};
     QAction *actTrash{}, *actRefresh{}, *actOpenTrash{}, *actUp{};
     QAction *actOpen{}, *actClose{}, *actInfo{}, *actRename{}, *actMove{}, *actDuplicate{}, *actLink{};
-    QAction *treeBtn{}, *columnBtn{}, *iconBtn{}, *toggleHiddenBtn{};
+    QAction *treeBtn{}, *columnBtn{}, *iconBtn{}, *usageBtn{}, *toggleHiddenBtn{};
     QAbstractItemView *currentView{}; // track active view
+    UsageMapView *usageView{};        // kept across view switches so its scan and tiles are reused
 
     // Button creation + wiring (declarations only; bodies in actions.h)
     void drawButtons();
@@ -202,13 +203,17 @@ private:
     void onCreateSoftlink();
 
     void onToggleHidden();
+    void onJump();
 
     void onViewTree();
     void onViewColumn();
     void onViewIcon();
+    void onViewUsage();
 
     // open/preview API (bodies in handleopen.h)
     QModelIndex currentIndex() const;
+    QStringList selectedPaths() const;
+    void runTransfer(bool move, const QStringList &sources, const QStringList &targets);
     bool isImageFile(const QString &path) const;
     void previewFile(const QModelIndex &idx);
     void openFile(const QModelIndex &idx);
@@ -218,20 +223,38 @@ private:
     QWidget* buildTreeWidget(const QModelIndex &root);
     QWidget* buildColumnWidget(const QModelIndex &root);
     QWidget* buildIconWidget(const QModelIndex &root);
+    QWidget* buildUsageWidget(const QModelIndex &root);
+
+    void goTo(const QString &p) {
+        if (QDir(p).exists()) {
+            currentRoot = model->index(p);
+            setViewMode(mode);
+        } else {
+            statusBar()->showMessage("Path not found", 2000);
+        }
+    }
 
     void setViewMode(ViewMode m) {
         mode = m;
         QWidget *old = centralWidget();
-        if (old) old->deleteLater();
+        if (old && old == usageView) {
+            takeCentralWidget();
+            usageView->setParent(this);
+            usageView->hide();
+        } else if (old) {
+            old->deleteLater();
+        }
         QWidget *w = nullptr;
         QModelIndex root = currentRoot.isValid() ? currentRoot : model->index(QDir::homePath());
         switch (mode) {
             case ViewMode::Tree:   w = buildTreeWidget(root);   break;
             case ViewMode::Column: w = buildColumnWidget(root); break;
             case ViewMode::Icon:   w = buildIconWidget(root);   break;
+            case ViewMode::Usage:  w = buildUsageWidget(root);  break;
         }
         setCentralWidget(w);
         if (crumbs) crumbs->setPath(model->filePath(currentRoot));
+        if (paths) paths->visit(model->filePath(root));
     }
 };
 
@@ -1 +1,2 @@
 g++ -std=c++17 colfm.cpp -o colfm `pkg-config --cflags --libs Qt6Widgets`
+g++ -std=c++17 colfm-cli.cpp -o colfm-cli `pkg-config --cflags --libs Qt6Core`
@@ -0,0 +1,477 @@
+// fscore.h
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QJsonObject>
+#include <QCryptographicHash>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---- ColFM core: QtCore only, shared by the GUI (colfm) and the headless CLI (colfm-cli) ----
+
+inline QString humanSize(qint64 bytes) {
+    const char *units[] = {"B","KB","MB","GB","TB"};
+    double sz = (double)bytes;
+    int u = 0;
+    while (sz >= 1024.0 && u < 4) { sz /= 1024.0; ++u; }
+    return QString::number(sz, 'f', (u==0?0:1)) + " " + units[u];
+}
+
+inline QString permsToString(QFile::Permissions p) {
+    auto bit = [p](QFile::Permission perm, QChar c){ return (p & perm) ? c : QChar('-'); };
+    return QString() +
+        bit(QFile::ReadOwner,  'r') + bit(QFile::WriteOwner, 'w') + bit(QFile::ExeOwner,  'x') +
+        bit(QFile::ReadGroup,  'r') + bit(QFile::WriteGroup, 'w') + bit(QFile::ExeGroup,  'x') +
+        bit(QFile::ReadOther,  'r') + bit(QFile::WriteOther, 'w') + bit(QFile::ExeOther,  'x');
+}
+
+// ---- Listing ----
+
+// The filter the GUI model browses with (dotfiles hidden unless asked for)
+inline QDir::Filters listingFilter(bool showHidden) {
+    QDir::Filters f = QDir::AllEntries | QDir::NoDotAndDotDot;
+    if (showHidden) f |= QDir::Hidden;
+    return f;
+}
+
+inline QFileInfoList listFolder(const QString &path, bool showHidden) {
+    return QDir(path).entryInfoList(listingFilter(showHidden), QDir::DirsFirst | QDir::Name | QDir::IgnoreCase);
+}
+
+inline QJsonObject fileInfoJson(const QFileInfo &fi) {
+    QJsonObject o;
+    o["name"]        = fi.fileName();
+    o["path"]        = fi.absoluteFilePath();
+    o["type"]        = fi.isSymLink() ? "symlink" : fi.isDir() ? "dir" : "file";
+    o["size"]        = fi.isDir() ? 0 : fi.size();
+    o["modified"]    = fi.lastModified().toString(Qt::ISODate);
+    o["permissions"] = permsToString(fi.permissions());
+    o["owner"]       = fi.owner();
+    o["group"]       = fi.group();
+    if (fi.isSymLink()) o["target"] = fi.symLinkTarget();
+    return o;
+}
+
+struct DirEntry {
+    QString name;
+    qint64 size = 0;
+    bool isDir = false;
+    quint64 dev = 0;             // st_dev, so scans can stay on one filesystem
+    quint64 ino = 0;             // st_ino; with dev identifies hard links to the same file
+    bool linked = false;         // regular file with more than one hard link
+};
+
+// Direct entries of one folder, dotfiles included, from lstat(). Symlinks are skipped so loops and
+// double counting can't happen. `*dev` receives the device of the folder itself (links followed).
+inline QVector<DirEntry> listDirectory(const QString &path, const std::atomic<bool> &stop, quint64 *dev = nullptr) {
+    QVector<DirEntry> out;
+    struct stat st;
+    // stat(), not lstat(): a scan rooted at a symlink ("~/data -> /mnt/data") belongs to the target's filesystem
+    if (dev) *dev = ::stat(QFile::encodeName(path).constData(), &st) == 0 ? quint64(st.st_dev) : 0;
+    QDirIterator it(path, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    while (it.hasNext() && !stop) {
+        const QString child = it.next();
+        if (::lstat(QFile::encodeName(child).constData(), &st) != 0 || S_ISLNK(st.st_mode)) continue;
+        const bool isDir = S_ISDIR(st.st_mode);
+        out.push_back({ it.fileName(), isDir ? 0 : qint64(st.st_size), isDir, quint64(st.st_dev),
+                        quint64(st.st_ino), !isDir && st.st_nlink > 1 });
+    }
+    return out;
+}
+
+// ---- Usage tree (Usage view, du, find, dupes) ----
+
+struct UsageNode {
+    QString name;                // root holds the absolute path, others just the file name
+    UsageNode *parent{};
+    int depth = 0;
+    bool isDir = false;
+    qint64 size = 0;             // apparent bytes seen so far at or below this node
+    bool otherDevice = false;    // mount point of another filesystem: not descended, like du -x
+    quint64 dev = 0, ino = 0;    // identity of the file, for hard links
+    bool extraLink = false;      // hard link whose inode was already counted elsewhere: size stays 0
+    std::vector<std::unique_ptr<UsageNode>> children;
+
+    QString path() const {
+        if (!parent) return name;
+        const QString dir = parent->path();
+        return dir.endsWith('/') ? dir + name : dir + "/" + name;   // root may be "/"
+    }
+};
+
+// Listings a UsageTree keeps in flight unless told otherwise
+inline int defaultScanThreads() { return qBound(2, QThread::idealThreadCount(), 8); }
+
+// Shared by every UsageTree and never destroyed, so a stat() stuck on a dead mount
+// can hold up neither a tree's destructor nor application exit. Each tree caps its own
+// share; the pool only grows to fit the largest cap asked for.
+inline QThreadPool *usageScanPool() {
+    static QThreadPool *pool = []{
+        auto *p = new QThreadPool;
+        p->setMaxThreadCount(defaultScanThreads());
+        return p;
+    }();
+    return pool;
+}
+
+// Scans a folder tree, listing folders on a thread pool and merging each listing on the
+// owning thread. Sizes grow as listings arrive, so readers see a refining total.
+// The scan stays on the root's filesystem (no /proc, /sys or network mounts below /).
+// Sizes are apparent sizes; a file with several hard links is counted once, at its
+// lexicographically smallest path, so totals don't depend on which listing arrived first.
+class UsageTree : public QObject {
+public:
+    explicit UsageTree(const QString &rootPath, int threads = 0, QObject *parent=nullptr) : QObject(parent) {
+        top = std::make_unique<UsageNode>();
+        top->name = QDir::cleanPath(QDir(rootPath).absolutePath());
+        top->isDir = true;
+        limit = threads > 0 ? threads : defaultScanThreads();
+        if (limit > usageScanPool()->maxThreadCount()) usageScanPool()->setMaxThreadCount(limit);
+    }
+    // Detaches instead of waiting: once `stop` is set under the lock no worker posts again,
+    // and deliveries already queued die with this object
+    ~UsageTree() override {
+        QMutexLocker locker(&link->lock);
+        link->stop = true;
+    }
+
+    // `dir` just got its listing; every size from it up to the root changed
+    void setOnChanged(std::function<void(UsageNode*)> cb) { onChanged = std::move(cb); }
+    void setOnFinished(std::function<void()> cb) { onFinished = std::move(cb); }
+
+    void start() { scan(top.get()); }
+
+    UsageNode *root() const { return top.get(); }
+    qint64 files() const { return nFiles; }
+    qint64 dirs() const { return nDirs; }
+    int pendingDirs() const { return pending; }
+    bool finished() const { return done; }
+
+private:
+    // Outlives the tree for as long as any worker still holds it
+    struct Link {
+        QMutex lock;
+        std::atomic<bool> stop{false};
+    };
+
+    std::unique_ptr<UsageNode> top;
+    std::shared_ptr<Link> link = std::make_shared<Link>();
+    int pending = 0;                 // folders queued or being listed
+    int limit = 0, running = 0;      // this tree's cap on listings in flight, and how many are
+    std::deque<UsageNode*> queue;    // folders waiting for a free slot
+    qint64 nFiles = 0, nDirs = 0;
+    quint64 rootDev = 0;
+    QHash<QPair<quint64, quint64>, UsageNode*> linkOwner;   // (dev, ino) -> the link that carries the size
+    bool done = false;
+    std::function<void(UsageNode*)> onChanged;
+    std::function<void()> onFinished;
+
+    // Workers only carry the node pointer back; the tree itself is never shared across threads
+    void scan(UsageNode *dir) {
+        ++pending;
+        queue.push_back(dir);
+        pump();
+    }
+
+    void pump() {
+        while (running < limit && !queue.empty()) {
+            UsageNode *dir = queue.front();
+            queue.pop_front();
+            ++running;
+            list(dir);
+        }
+    }
+
+    void list(UsageNode *dir) {
+        const QString path = dir->path();
+        auto shared = link;
+        usageScanPool()->start([this, dir, path, shared]{
+            if (shared->stop) return;
+            quint64 dev = 0;
+            QVector<DirEntry> entries = listDirectory(path, shared->stop, &dev);
+            QMutexLocker locker(&shared->lock);
+            if (shared->stop) return;    // `this` may be gone; never touch it past this point
+            QMetaObject::invokeMethod(this, [this, dir, entries, dev]{ merge(dir, entries, dev); }, Qt::QueuedConnection);
+        });
+    }
+
+    // Whether hard link `n` (being merged into `dir`) carries its inode's size. When it sorts
+    // before the current owner the size moves over: off the owner's folders, or off `added`
+    // when the owner is in this same listing and hasn't been added up yet.
+    bool claimLink(UsageNode *n, UsageNode *dir, qint64 &added) {
+        UsageNode *&owner = linkOwner[QPair<quint64, quint64>(n->dev, n->ino)];
+        if (owner && owner->path() <= n->path()) return false;
+        if (owner && owner->parent == dir) {
+            added -= owner->size;
+        } else if (owner) {
+            for (UsageNode *a = owner->parent; a; a = a->parent) a->size -= owner->size;
+            if (onChanged) onChanged(owner->parent);
+        }
+        if (owner) {
+            owner->size = 0;
+            owner->extraLink = true;
+        }
+        owner = n;
+        return true;
+    }
+
+    void merge(UsageNode *dir, const QVector<DirEntry> &entries, quint64 dev) {
+        --pending;
+        --running;
+        ++nDirs;
+        if (dir == top.get()) rootDev = dev;
+        qint64 added = 0;
+        dir->children.reserve(entries.size());
+        for (const DirEntry &e : entries) {
+            auto child = std::make_unique<UsageNode>();
+            child->name = e.name;
+            child->parent = dir;
+            child->depth = dir->depth + 1;
+            child->isDir = e.isDir;
+            child->dev = e.dev;
+            child->ino = e.ino;
+            child->size = e.size;
+            UsageNode *node = child.get();
+            dir->children.push_back(std::move(child));
+            if (e.linked && !claimLink(node, dir, added)) {
+                node->extraLink = true;
+                node->size = 0;
+            }
+            added += node->size;
+            if (e.isDir && e.dev != rootDev) node->otherDevice = true;
+            else if (e.isDir) scan(node);
+            else ++nFiles;
+        }
+        for (UsageNode *n = dir; n; n = n->parent) n->size += added;
+        pump();
+        if (onChanged) onChanged(dir);
+        if (pending == 0) {
+            done = true;
+            if (onFinished) onFinished();
+        }
+    }
+};
+
+struct FileSize {
+    QString path;
+    qint64 size = 0;
+    quint64 dev = 0, ino = 0;    // 0/0 when unknown
+};
+
+// Files at or below `n` with their real length (hard links the tree counted once included)
+inline void collectFiles(const UsageNode *n, QVector<FileSize> &out) {
+    if (!n->isDir) {
+        qint64 size = n->size;
+        if (n->extraLink) {
+            struct stat st;
+            if (::lstat(QFile::encodeName(n->path()).constData(), &st) == 0) size = qint64(st.st_size);
+        }
+        out.push_back({ n->path(), size, n->dev, n->ino });
+        return;
+    }
+    for (const auto &c : n->children) collectFiles(c.get(), out);
+}
+
+// ---- Duplicates ----
+
+// SHA-256 of the first `limit` bytes (all of it when limit < 0); empty on read errors
+inline QByteArray hashFile(const QString &path, qint64 limit = -1) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    char buf[1 << 16];
+    qint64 left = limit < 0 ? f.size() : limit;
+    while (left > 0) {
+        const qint64 n = f.read(buf, qMin<qint64>(left, sizeof buf));
+        if (n <= 0) break;
+        h.addData(QByteArrayView(buf, n));
+        left -= n;
+    }
+    if (f.error() != QFileDevice::NoError) return QByteArray();
+    return h.result();
+}
+
+// Groups of identical files: same size, then same 64 KiB head, then same full hash.
+// Paths to one inode (hard links, overlapping inputs) are the same file and are kept once.
+// Hashing runs on `pool`; `progress(hashed, total)` is called from the calling thread.
+inline QVector<QStringList> findDuplicates(const QVector<FileSize> &files, qint64 minSize, QThreadPool *pool,
+                                           std::function<void(int, int)> progress = nullptr) {
+    static constexpr qint64 kHead = 64 * 1024;
+
+    QHash<qint64, QStringList> bySize;
+    QSet<QPair<quint64, quint64>> inodes;
+    for (const FileSize &f : files) {
+        if (f.size <= 0 || f.size < minSize) continue;
+        if (f.ino) {
+            const QPair<quint64, quint64> id(f.dev, f.ino);
+            if (inodes.contains(id)) continue;
+            inodes.insert(id);
+        }
+        bySize[f.size] << f.path;
+    }
+
+    // One hashing pass over every group of 2+; regroups each by (size, hash)
+    auto refine = [&](const QHash<qint64, QStringList> &groups, bool full) {
+        QVector<QPair<qint64, QString>> work;
+        for (auto it = groups.constBegin(); it != groups.constEnd(); ++it)
+            if (it.value().size() > 1)
+                for (const QString &p : it.value()) work.push_back({ it.key(), p });
+
+        // Workers write disjoint slots through raw pointers, so nothing is detached concurrently
+        QVector<QByteArray> digests(work.size());
+        const QPair<qint64, QString> *items = work.constData();
+        QByteArray *slots = digests.data();
+        std::atomic<int> hashed{0};
+        for (int i = 0; i < work.size(); ++i) {
+            pool->start([items, slots, i, full, &hashed]{
+                slots[i] = hashFile(items[i].second, full ? -1 : kHead);
+                ++hashed;
+            });
+        }
+        while (!pool->waitForDone(100))
+            if (progress) progress(hashed.load(), work.size());
+        if (progress) progress(work.size(), work.size());
+
+        QHash<QPair<qint64, QByteArray>, QStringList> out;
+        for (int i = 0; i < work.size(); ++i)
+            if (!digests[i].isEmpty()) out[{ work[i].first, digests[i] }] << work[i].second;
+        return out;
+    };
+
+    const auto heads = refine(bySize, false);
+
+    // Files no bigger than the head are already fully hashed
+    QVector<QStringList> result;
+    QHash<qint64, QStringList> needFull;
+    for (auto it = heads.constBegin(); it != heads.constEnd(); ++it) {
+        if (it.value().size() < 2) continue;
+        if (it.key().first <= kHead) result << it.value();
+        else needFull[it.key().first] += it.value();
+    }
+    // needFull may now merge groups with different heads; the full hash splits them again
+    const auto fulls = refine(needFull, true);
+    for (auto it = fulls.constBegin(); it != fulls.constEnd(); ++it)
+        if (it.value().size() > 1) result << it.value();
+
+    // Most wasted space first, paths sorted within a group
+    QHash<QString, qint64> sizeOf;
+    for (const FileSize &f : files) sizeOf.insert(f.path, f.size);
+    for (QStringList &g : result) g.sort();
+    std::sort(result.begin(), result.end(), [&](const QStringList &a, const QStringList &b){
+        const qint64 wa = sizeOf.value(a.first()) * (a.size() - 1);
+        const qint64 wb = sizeOf.value(b.first()) * (b.size() - 1);
+        return wa != wb ? wa > wb : a.first() < b.first();
+    });
+    return result;
+}
+
+// ---- File operations (copy, move, trash) ----
+
+// Whether `dest` is `src` or lies below it, which would make a folder copy recurse into itself
+inline bool isSameOrInside(const QString &dest, const QString &src) {
+    const QString s = QDir::cleanPath(QDir(src).absolutePath());
+    const QString d = QDir::cleanPath(QDir(dest).absolutePath());
+    return d == s || d.startsWith(s.endsWith('/') ? s : s + "/");
+}
+
+// Text of a symlink as stored (may be relative or dangling), not the resolved absolute target
+inline QString readLinkText(const QString &path) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    return QFileInfo(path).readSymLink();
+#else
+    QByteArray buf(4096, Qt::Uninitialized);
+    const ssize_t n = ::readlink(QFile::encodeName(path).constData(), buf.data(), size_t(buf.size()));
+    return n < 0 ? QString() : QFile::decodeName(buf.left(int(n)));
+#endif
+}
+
+// Copy `src` (file, folder or symlink) to the new path `dest`; never overwrites.
+// `onFile(bytes)` fires after each regular file is copied.
+inline bool copyPath(const QString &src, const QString &dest, QString *error = nullptr,
+                     const std::function<void(qint64)> &onFile = nullptr) {
+    auto fail = [&](const QString &msg){ if (error) *error = msg; return false; };
+    const QFileInfo fi(src);
+    if (!fi.exists() && !fi.isSymLink()) return fail(QString("%1: not found").arg(src));
+    if (QFileInfo::exists(dest) || QFileInfo(dest).isSymLink()) return fail(QString("%1: already exists").arg(dest));
+    if (fi.isDir() && !fi.isSymLink() && isSameOrInside(dest, src))
+        return fail(QString("%1: cannot copy a folder into itself").arg(src));
+
+    if (fi.isSymLink()) {
+        const QString target = readLinkText(src);
+        if (target.isEmpty() || !QFile::link(target, dest)) return fail(QString("%1: cannot create link").arg(dest));
+        return true;
+    }
+    if (fi.isDir()) {
+        if (!QDir().mkpath(dest)) return fail(QString("%1: cannot create folder").arg(dest));
+        const QStringList names = QDir(src).entryList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+        for (const QString &name : names)
+            if (!copyPath(src + "/" + name, dest + "/" + name, error, onFile)) return false;
+        return true;
+    }
+    QFile in(src);
+    if (!in.copy(dest)) return fail(QString("%1: %2").arg(src, in.errorString()));
+    if (onFile) onFile(fi.size());
+    return true;
+}
+
+// Rename when possible; across filesystems fall back to copy + delete
+inline bool movePath(const QString &src, const QString &dest, QString *error = nullptr,
+                     const std::function<void(qint64)> &onFile = nullptr) {
+    if (QFileInfo::exists(dest) || QFileInfo(dest).isSymLink()) {
+        if (error) *error = QString("%1: already exists").arg(dest);
+        return false;
+    }
+    const QFileInfo fi(src);
+    if (fi.isDir() && !fi.isSymLink() && isSameOrInside(dest, src)) {
+        if (error) *error = QString("%1: cannot move a folder into itself").arg(src);
+        return false;
+    }
+    if (QDir().rename(src, dest)) return true;
+    if (!copyPath(src, dest, error, onFile)) return false;
+
+    const bool removed = (fi.isDir() && !fi.isSymLink()) ? QDir(src).removeRecursively() : QFile::remove(src);
+    if (!removed && error) *error = QString("%1: copied but could not remove the original").arg(src);
+    return removed;
+}
+
+// freedesktop.org Trash (~/.local/share/Trash), the folder the GUI's Open Trash shows
+inline bool trashPath(const QString &path, QString *error = nullptr) {
+    QFile f(path);
+    if (f.moveToTrash()) return true;
+    if (error) *error = QString("%1: %2").arg(path, f.errorString());
+    return false;
+}
+
+// "name copy.ext", then "name copy 2.ext", … next to `path`
+inline QString uniqueCopyName(const QString &path) {
+    const QFileInfo fi(path);
+    const QString dir = fi.absolutePath();
+    // A dotfile like ".bashrc" has no suffix: the copy is ".bashrc copy", not " copy.bashrc"
+    const QString name = fi.fileName();
+    const bool noSuffix = fi.isDir() || fi.suffix().isEmpty() || (name.startsWith('.') && name.count('.') == 1);
+    const QString base = noSuffix ? name : fi.completeBaseName();
+    const QString ext = noSuffix ? QString() : "." + fi.suffix();
+    for (int n = 1; ; ++n) {
+        const QString candidate = dir + "/" + base + (n == 1 ? QString(" copy") : QString(" copy %1").arg(n)) + ext;
+        if (!QFileInfo::exists(candidate) && !QFileInfo(candidate).isSymLink()) return candidate;
+    }
+}
@@ -11,6 +11,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QMessageBox>
+#include "fscore.h" // humanSize, permsToString
 
 // ---- ColFM open/preview helpers (no duplicated rendering logic) ----
 
@@ -26,20 +27,13 @@ inline QModelIndex ColFM::currentIndex() const {
     return idx;
 }
 
-inline QString humanSize(qint64 bytes) {
-    const char *units[] = {"B","KB","MB","GB","TB"};
-    double sz = (double)bytes;
-    int u = 0;
-    while (sz >= 1024.0 && u < 4) { sz /= 1024.0; ++u; }
-    return QString::number(sz, 'f', (u==0?0:1)) + " " + units[u];
-}
-
-inline QString permsToString(QFile::Permissions p) {
-    auto bit = [p](QFile::Permission perm, QChar c){ return (p & perm) ? c : QChar('-'); };
-    return QString() +
-        bit(QFile::ReadOwner,  'r') + bit(QFile::WriteOwner, 'w') + bit(QFile::ExeOwner,  'x') +
-        bit(QFile::ReadGroup,  'r') + bit(QFile::WriteGroup, 'w') + bit(QFile::ExeGroup,  'x') +
-        bit(QFile::ReadOther,  'r') + bit(QFile::WriteOther, 'w') + bit(QFile::ExeOther,  'x');
+// Paths of the selected rows only; the current index alone is not a selection
+inline QStringList ColFM::selectedPaths() const {
+    QStringList out;
+    if (!currentView || !currentView->selectionModel()) return out;
+    for (const QModelIndex &idx : currentView->selectionModel()->selectedRows())
+        out << model->filePath(idx);
+    return out;
 }
 
 inline bool ColFM::isImageFile(const QString &path) const {
@@ -0,0 +1,94 @@
+#pragma once
+#include <QDialog>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include <QKeyEvent>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include "pathindex.h"
+
+// Ctrl+P "Go to Folder": fuzzy search over visited folders and their neighbours
+class JumpDialog : public QDialog {
+public:
+    explicit JumpDialog(PathIndex *idx, QWidget *parent=nullptr) : QDialog(parent), index(idx) {
+        setWindowTitle("Go to Folder");
+        resize(640, 420);
+
+        edit = new QLineEdit(this);
+        edit->setPlaceholderText("Folder name or path…");
+        list = new QListWidget(this);
+        list->setUniformItemSizes(true);
+
+        auto *layout = new QVBoxLayout(this);
+        layout->addWidget(edit);
+        layout->addWidget(list);
+
+        edit->installEventFilter(this);
+        QObject::connect(edit, &QLineEdit::textEdited, this, [this](const QString &t){ browsed = false; requery(t); });
+        QObject::connect(edit, &QLineEdit::returnPressed, this, [this]{ onEnter(); });
+        QObject::connect(list, &QListWidget::itemActivated, this, [this]{ acceptCurrent(); });
+
+        requery(QString()); // most frecent folders first
+    }
+
+    QString chosenPath() const { return chosen; }
+
+protected:
+    // Up/Down/PgUp/PgDn move through the results while typing continues in the query field
+    bool eventFilter(QObject *o, QEvent *e) override {
+        if (o == edit && e->type() == QEvent::KeyPress) {
+            const int key = static_cast<QKeyEvent*>(e)->key();
+            if (key == Qt::Key_Up || key == Qt::Key_Down || key == Qt::Key_PageUp || key == Qt::Key_PageDown) {
+                QCoreApplication::sendEvent(list, e);
+                browsed = true;
+                return true;
+            }
+        }
+        return QDialog::eventFilter(o, e);
+    }
+
+private:
+    PathIndex *index{};
+    QLineEdit *edit{};
+    QListWidget *list{};
+    QString chosen;
+    QString shownFor;             // query the list currently shows results for
+    bool browsed = false;         // a result was picked with the arrow keys since the last edit
+    bool enterPending = false;    // Enter came before the results for the typed text
+
+    // A typed absolute or ~ path to an existing folder, which may not be a candidate at all
+    QString typedFolder() const {
+        QString t = edit->text().trimmed();
+        if (t == "~" || t.startsWith("~/")) t = QDir::homePath() + t.mid(1);
+        if (!QDir::isAbsolutePath(t) || !QFileInfo(t).isDir()) return QString();
+        return QDir::cleanPath(t);
+    }
+
+    // Results arrive asynchronously: never accept a row that belongs to an older query
+    void onEnter() {
+        const QString typed = typedFolder();
+        if (!browsed && !typed.isEmpty()) { chosen = typed; accept(); return; }
+        if (shownFor == edit->text()) acceptCurrent();
+        else enterPending = true;
+    }
+
+    void acceptCurrent() {
+        enterPending = false;
+        const QListWidgetItem *it = list->currentItem();
+        if (!it) return;
+        chosen = it->text();
+        accept();
+    }
+
+    void requery(const QString &text) {
+        index->match(text, this, [this, text](const QStringList &paths){
+            list->clear();
+            list->addItems(paths);
+            if (list->count()) list->setCurrentRow(0);
+            shownFor = text;
+            if (enterPending && text == edit->text()) acceptCurrent();
+        });
+    }
+};
@@ -0,0 +1,432 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QPair>
+#include <QSet>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QTimer>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ---- Path index: frecency of visited folders, lazy sibling scan, fuzzy top-k matching ----
+
+// Visit counts weighted by recency, persisted as "visits<TAB>last<TAB>path" lines
+class FrecencyDb {
+public:
+    FrecencyDb()
+        : file(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/frecency.tsv") {
+        load();
+    }
+
+    void visit(const QString &path) {
+        if (path.isEmpty() || path == lastVisited) return;   // view switches and refreshes aren't visits
+        lastVisited = path;
+        Entry &e = entries[path];
+        e.visits += 1;
+        e.last = QDateTime::currentSecsSinceEpoch();
+        age();
+        save();
+    }
+
+    double score(const QString &path) const {
+        const auto it = entries.constFind(path);
+        return it == entries.constEnd() ? 0 : it->visits * recency(QDateTime::currentSecsSinceEpoch() - it->last);
+    }
+
+    QHash<QString, double> scores() const {
+        QHash<QString, double> out;
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+            out.insert(it.key(), it->visits * recency(now - it->last));
+        return out;
+    }
+
+private:
+    struct Entry { double visits = 0; qint64 last = 0; };
+    static constexpr double kMaxTotal = 5000;
+
+    QString file;
+    QHash<QString, Entry> entries;
+    QString lastVisited;
+
+    static double recency(qint64 age) {
+        if (age < 3600)     return 4;
+        if (age < 86400)    return 2;
+        if (age < 7*86400)  return 0.5;
+        return 0.25;
+    }
+
+    // Past kMaxTotal visits everything decays, and folders that fall below one visit are forgotten
+    void age() {
+        double total = 0;
+        for (const Entry &e : entries) total += e.visits;
+        if (total <= kMaxTotal) return;
+        for (auto it = entries.begin(); it != entries.end(); ) {
+            it->visits *= 0.9;
+            if (it->visits < 1) it = entries.erase(it);
+            else ++it;
+        }
+    }
+
+    void load() {
+        QFile f(file);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+        QTextStream ts(&f);
+        while (!ts.atEnd()) {
+            const QStringList parts = ts.readLine().split('\t');
+            if (parts.size() != 3) continue;
+            entries.insert(parts[2], Entry{ parts[0].toDouble(), parts[1].toLongLong() });
+        }
+    }
+
+    void save() const {
+        QDir().mkpath(QFileInfo(file).absolutePath());
+        QFile f(file);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return;
+        QTextStream ts(&f);
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+            ts << it->visits << '\t' << it->last << '\t' << it.key() << '\n';
+    }
+};
+
+struct FuzzyCandidate {
+    QString path;
+    QByteArray key;       // lower-cased UTF-8 path
+    int base = 0;         // offset of the last path component in `key`
+    quint64 mask = 0;     // fuzzyMask(key): cheap reject before the real match
+    double boost = 0;     // frecency bonus
+};
+
+inline int fuzzyBit(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= '0' && c <= '9') return 26 + (c - '0');
+    return 36 + c % 28;
+}
+
+inline quint64 fuzzyMask(const QByteArray &s) {
+    quint64 m = 0;
+    for (char c : s) m |= quint64(1) << fuzzyBit(uchar(c));
+    return m;
+}
+
+inline FuzzyCandidate makeFuzzyCandidate(const QString &path, double boost = 0) {
+    FuzzyCandidate c;
+    c.path = path;
+    c.key = path.toLower().toUtf8();
+    c.base = c.key.lastIndexOf('/') + 1;
+    c.mask = fuzzyMask(c.key);
+    c.boost = boost;
+    return c;
+}
+
+// Index of the first `c` in s[from, n), or -1; 16 bytes per step with SSE2
+inline int fuzzyFind(const char *s, int from, int n, char c) {
+    int i = from;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (bits) return i + __builtin_ctz(unsigned(bits));
+    }
+#endif
+    if (i >= n) return -1;
+    const void *hit = std::memchr(s + i, c, size_t(n - i));
+    return hit ? int(static_cast<const char*>(hit) - s) : -1;
+}
+
+inline bool fuzzyBoundary(char c) {
+    return c == '/' || c == '_' || c == '-' || c == '.' || c == ' ';
+}
+
+// Greedy left-to-right match of `q` in s[from, n); -1 when `q` isn't a subsequence
+inline int fuzzyRun(const char *s, int n, int from, const QByteArray &q) {
+    int score = 0, prev = -2, pos = from;
+    for (char ch : q) {
+        const int at = fuzzyFind(s, pos, n, ch);
+        if (at < 0) return -1;
+        score += 16;
+        if (at == prev + 1) score += 12;                    // consecutive run
+        else if (prev >= 0) score -= qMin(at - prev - 1, 8); // gap
+        if (at == 0 || fuzzyBoundary(s[at - 1])) score += 10;
+        prev = at;
+        pos = at + 1;
+    }
+    return score;
+}
+
+// Prefers matches inside the folder name, then anywhere in the path; shorter paths win ties
+inline bool fuzzyScore(const FuzzyCandidate &c, const QByteArray &q, int &score) {
+    const char *s = c.key.constData();
+    const int n = c.key.size();
+    int run = fuzzyRun(s, n, c.base, q);
+    if (run >= 0) run += 24;
+    else run = fuzzyRun(s, n, 0, q);
+    if (run < 0) return false;
+    score = run - n / 16;
+    return true;
+}
+
+// Best `k` paths for `query`; an empty query ranks by frecency alone.
+// Gives up early (empty result) once `seq` moves past `gen`.
+inline QStringList fuzzyTopK(const std::vector<FuzzyCandidate> &cands, const QString &query, int k,
+                             const std::atomic<int> *seq=nullptr, int gen=0) {
+    const QByteArray q = query.toLower().toUtf8();
+    const quint64 qmask = fuzzyMask(q);
+    std::vector<std::pair<double, int>> hits;
+    for (int i = 0; i < int(cands.size()); ++i) {
+        if (seq && (i & 4095) == 0 && seq->load() != gen) return {};
+        const FuzzyCandidate &c = cands[size_t(i)];
+        if (q.isEmpty()) {
+            if (c.boost > 0) hits.push_back({ c.boost, i });
+            continue;
+        }
+        if ((c.mask & qmask) != qmask) continue;
+        int score = 0;
+        if (fuzzyScore(c, q, score)) hits.push_back({ score + c.boost, i });
+    }
+
+    auto better = [](const std::pair<double, int> &a, const std::pair<double, int> &b){ return a.first > b.first; };
+    const size_t top = std::min(hits.size(), size_t(k));
+    std::partial_sort(hits.begin(), hits.begin() + top, hits.end(), better);
+
+    QStringList out;
+    out.reserve(int(top));
+    for (size_t i = 0; i < top; ++i) out << cands[size_t(hits[i].second)].path;
+    return out;
+}
+
+// Shared by every PathIndex and never destroyed, so a listing stuck on a dead network mount
+// holds up neither a PathIndex destructor nor application exit
+inline QThreadPool *pathScanPool() {
+    static QThreadPool *pool = []{ auto *p = new QThreadPool; p->setMaxThreadCount(4); return p; }();
+    return pool;
+}
+
+// One thread: each PathIndex's candidate vector is only ever touched from here
+inline QThreadPool *pathMatchPool() {
+    static QThreadPool *pool = []{ auto *p = new QThreadPool; p->setMaxThreadCount(1); return p; }();
+    return pool;
+}
+
+// Candidate folders for the path bar and the jump dialog: every visited folder plus the
+// subfolders of visited folders and their parents, listed lazily on a thread pool.
+// Matching runs on its own thread; the GUI thread never touches the filesystem here.
+class PathIndex : public QObject {
+public:
+    explicit PathIndex(QObject *parent=nullptr) : QObject(parent) {
+        // New listings widen the candidate set; refresh whoever is still waiting on results
+        regrow.setSingleShot(true);
+        regrow.setInterval(50);
+        QObject::connect(&regrow, &QTimer::timeout, this, [this]{
+            for (auto it = queries.begin(); it != queries.end(); ++it)
+                if (it->done) run(*it);
+        });
+    }
+    // Detaches instead of waiting, like UsageTree: once `stop` is set under the lock no worker
+    // posts again, and matches still running give up on their next sequence check
+    ~PathIndex() override {
+        QMutexLocker locker(&link->lock);
+        link->stop = true;
+        for (const Query &q : queries) ++*q.seq;
+    }
+
+    void visit(const QString &path) {
+        const QString p = QDir::cleanPath(path);
+        if (p.isEmpty()) return;
+        db.visit(p);
+        delta.push_back({ p, db.score(p) });   // new or re-ranked; no full rebuild
+        listed.remove(p);            // revisiting refreshes that folder's children
+        scanDir(p);
+        scanDir(parentOf(p));
+    }
+
+    // Fuzzy-match `text` in the background. `done` runs on the GUI thread with the best `k`
+    // paths, unless `ctx` is gone or has asked again in the meantime.
+    void match(const QString &text, QObject *ctx, std::function<void(const QStringList&)> done, int k = 50) {
+        auto it = queries.find(ctx);
+        if (it == queries.end()) {
+            it = queries.insert(ctx, Query());
+            it->seq = std::make_shared<std::atomic<int>>(0);
+            QObject::connect(ctx, &QObject::destroyed, this, [this, ctx]{ queries.remove(ctx); });
+        }
+        it->ctx = ctx;
+        it->text = expandHome(text.trimmed());
+        it->done = std::move(done);
+        it->k = k;
+
+        // Typing a path: list the folder being typed into, without waiting for it
+        if (it->text.startsWith('/')) {
+            const int slash = it->text.lastIndexOf('/');
+            scanDir(slash == 0 ? QString("/") : QDir::cleanPath(it->text.left(slash)));
+        }
+
+        run(*it);
+    }
+
+    // Stop refreshing `ctx` when new listings arrive (completion accepted, dialog closed)
+    void forget(QObject *ctx) {
+        auto it = queries.find(ctx);
+        if (it == queries.end()) return;
+        ++*it->seq;                  // drops anything still in flight
+        it->done = nullptr;
+    }
+
+private:
+    struct Query {
+        QObject *ctx{};
+        QString text;
+        std::function<void(const QStringList&)> done;
+        int k = 50;
+        std::shared_ptr<std::atomic<int>> seq;
+    };
+
+    // Outlives the index for as long as any worker still holds it
+    struct Link {
+        QMutex lock;
+        bool stop = false;
+    };
+
+    FrecencyDb db;
+    QHash<QString, QStringList> listed;     // folder -> subfolder names
+    QSet<QString> inFlight;
+    QHash<QObject*, Query> queries;
+    bool stale = true;                       // next match builds the candidates from scratch
+    QVector<QPair<QString, double>> delta;   // (path, frecency) not yet handed to the match thread
+
+    // Candidates, grown in place as folders are visited and listed
+    struct CandidateSet {
+        std::vector<FuzzyCandidate> list;
+        QHash<QString, int> at;              // path -> index in `list`
+
+        void upsert(const QString &path, double score) {
+            const auto it = at.constFind(path);
+            if (it != at.constEnd()) { list[size_t(*it)].boost = boostFor(list[size_t(*it)], score); return; }
+            FuzzyCandidate c = makeFuzzyCandidate(path);
+            c.boost = boostFor(c, score);
+            at.insert(path, int(list.size()));
+            list.push_back(std::move(c));
+        }
+        static double boostFor(const FuzzyCandidate &c, double score) {
+            double b = 8 * std::log2(1 + score);
+            if (c.base < c.key.size() && c.key[c.base] == '.') b -= 4;   // dotfolders sink
+            return b;
+        }
+    };
+
+    // Only ever touched by the single match thread
+    std::shared_ptr<CandidateSet> cands = std::make_shared<CandidateSet>();
+
+    std::shared_ptr<Link> link = std::make_shared<Link>();
+    QTimer regrow;
+
+    static QString expandHome(const QString &s) {
+        if (s == "~" || s.startsWith("~/")) return QDir::homePath() + s.mid(1);
+        return s;
+    }
+
+    static QString parentOf(const QString &p) {
+        const int slash = p.lastIndexOf('/');
+        if (slash < 0) return QString();
+        if (slash == 0) return p.size() > 1 ? QString("/") : QString();
+        return p.left(slash);
+    }
+
+    // A listing still running after this long is presumed stuck (dead mount) and stops counting
+    // against the pool, so one hung folder can't starve completion everywhere else
+    static constexpr int kStuckMs = 1000;
+
+    void scanDir(const QString &dir) {
+        if (dir.isEmpty() || listed.contains(dir) || inFlight.contains(dir)) return;
+        inFlight.insert(dir);
+        auto shared = link;
+        auto state = std::make_shared<std::atomic<int>>(0);   // 0 running, 1 presumed stuck, 2 done
+        QTimer::singleShot(kStuckMs, this, [state]{
+            int running = 0;
+            if (state->compare_exchange_strong(running, 1))
+                pathScanPool()->setMaxThreadCount(pathScanPool()->maxThreadCount() + 1);
+        });
+        pathScanPool()->start([this, dir, shared, state]{
+            const QStringList names = QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+            if (state->exchange(2) == 1)
+                pathScanPool()->setMaxThreadCount(pathScanPool()->maxThreadCount() - 1);
+            QMutexLocker locker(&shared->lock);
+            if (shared->stop) return;    // `this` may be gone; never touch it past this point
+            QMetaObject::invokeMethod(this, [this, dir, names]{
+                inFlight.remove(dir);
+                listed.insert(dir, names);
+                if (names.isEmpty()) return;
+                const QString prefix = dir == "/" ? dir : dir + "/";
+                for (const QString &name : names) delta.push_back({ prefix + name, db.score(prefix + name) });
+                if (!regrow.isActive()) regrow.start();
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    // Full build, only for the first match: later changes arrive as deltas
+    static void buildCandidates(CandidateSet &out, const QHash<QString, QStringList> &dirs,
+                                const QHash<QString, double> &scores) {
+        out = CandidateSet();
+        for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) out.upsert(it.key(), it.value());
+        for (auto it = dirs.constBegin(); it != dirs.constEnd(); ++it) {
+            const QString prefix = it.key() == "/" ? it.key() : it.key() + "/";
+            for (const QString &name : it.value()) {
+                const QString path = prefix + name;
+                if (!out.at.contains(path)) out.upsert(path, scores.value(path));
+            }
+        }
+    }
+
+    void run(const Query &q) {
+        const int gen = ++*q.seq;
+        const bool rebuild = stale;
+        stale = false;
+        // Implicitly shared copies: the worker rebuilds from these without touching `this`
+        const QHash<QString, QStringList> dirs = rebuild ? listed : QHash<QString, QStringList>();
+        const QHash<QString, double> scores = rebuild ? db.scores() : QHash<QString, double>();
+        QVector<QPair<QString, double>> changes;
+        changes.swap(delta);                 // a rebuild already covers them
+        if (rebuild) changes.clear();
+        auto seq = q.seq;
+        auto shared = cands;
+        auto alive = link;
+        QObject *ctx = q.ctx;
+        const QString text = q.text;
+        const int k = q.k;
+
+        pathMatchPool()->start([this, rebuild, dirs, scores, changes, seq, shared, alive, ctx, text, k, gen]{
+            // Applied even if superseded: later queries rely on them
+            if (rebuild) buildCandidates(*shared, dirs, scores);
+            for (const auto &c : changes) shared->upsert(c.first, c.second);
+            if (seq->load() != gen) return;
+            const QStringList top = fuzzyTopK(shared->list, text, k, seq.get(), gen);
+            QMutexLocker locker(&alive->lock);
+            if (alive->stop || seq->load() != gen) return;
+            QMetaObject::invokeMethod(this, [this, seq, ctx, top, gen]{
+                auto it = queries.find(ctx);
+                if (it == queries.end() || it->seq != seq || seq->load() != gen) return;
+                it->done(top);
+            }, Qt::QueuedConnection);
+        });
+    }
+};
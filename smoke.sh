@@ -0,0 +1,74 @@
+#!/bin/sh
+# Build both targets warning-clean, then run colfm-cli du/find/dupes/cp on a small fixture tree.
+set -eu
+
+T=$(mktemp -d)
+trap 'rm -rf "$T"' EXIT
+
+# Binaries go to the temp dir, so the checked-in ./colfm is left alone.
+# Qt's own headers are included as system headers so -Werror only judges ColFM's code.
+FLAGS="-std=c++17 -fPIC -Wall -Wextra -Werror"
+qt() { pkg-config --cflags --libs "$1" | sed 's/-I/-isystem /g'; }
+mkdir "$T/bin"
+g++ $FLAGS colfm.cpp -o "$T/bin/colfm" `qt Qt6Widgets`
+g++ $FLAGS colfm-cli.cpp -o "$T/bin/colfm-cli" `qt Qt6Core`
+
+CLI="$T/bin/colfm-cli"
+
+fail() { echo "smoke: $*" >&2; exit 1; }
+
+# Fixture: two identical files, one hard link, one unique file, a nested folder
+mkdir -p "$T/src/sub/deep" "$T/out"
+printf 'same content\n' > "$T/src/a.txt"
+printf 'same content\n' > "$T/src/sub/b.txt"
+printf 'different\n'    > "$T/src/sub/deep/c.log"
+ln "$T/src/a.txt" "$T/src/a-link.txt"
+ln -s a.txt "$T/src/a-sym"
+
+# du: every folder listed, root last; the hard link is counted once
+"$CLI" du "$T/src" > "$T/du.txt"
+[ "$(wc -l < "$T/du.txt")" -eq 3 ] || fail "du: expected 3 folders"
+tail -n 1 "$T/du.txt" | grep -q "^36	$T/src\$" || fail "du: wrong root total: $(tail -n 1 "$T/du.txt")"
+
+# find: glob and fuzzy
+"$CLI" find --name '*.log' "$T/src" | grep -q "/deep/c.log\$" || fail "find --name"
+"$CLI" find --fuzzy dpcl --limit 1 "$T/src" | grep -q "/deep/c.log\$" || fail "find --fuzzy"
+
+# dupes: one group of two, sub/b.txt plus one of the two links to a.txt's inode
+"$CLI" dupes "$T/src" > "$T/dupes.txt"
+grep -q "/sub/b.txt\$" "$T/dupes.txt" || fail "dupes: b.txt missing"
+[ "$(grep -c "^$T/src/a" "$T/dupes.txt")" -eq 1 ] || fail "dupes: hard links reported as duplicates"
+
+# cp: recursive copy keeps the symlink text, never overwrites, refuses to copy into itself
+"$CLI" cp --json "$T/src" "$T/out" > "$T/cp.json"
+[ -f "$T/out/src/sub/deep/c.log" ] || fail "cp: nested file missing"
+[ "$(readlink "$T/out/src/a-sym")" = "a.txt" ] || fail "cp: symlink target changed"
+! "$CLI" cp "$T/src" "$T/out" 2>/dev/null || fail "cp: overwrote an existing target"
+! "$CLI" cp "$T/src" "$T/src/sub" 2>/dev/null || fail "cp: copied a folder into itself"
+
+# Fuzzy top-k over 100k candidates must fit in one 60 Hz frame (16 ms), optimised build
+cat > "$T/fuzzy_timing.cpp" <<'CPP'
+#include <QElapsedTimer>
+#include <cstdio>
+#include "pathindex.h"
+int main() {
+    const char *parts[] = { "src", "lib", "docs", "build", "test", "include", "assets", "config", "tools", "vendor" };
+    std::vector<FuzzyCandidate> cands;
+    for (int i = 0; i < 100000; ++i)
+        cands.push_back(makeFuzzyCandidate(QString("/home/user/%1/%2/project-%3/%4")
+            .arg(parts[i % 10]).arg(parts[(i / 10) % 10]).arg(i / 100).arg(parts[(i / 7) % 10]), i % 13));
+    qint64 worst = 0;
+    for (const char *q : { "s", "src", "doclib", "prj42", "hmusrbldtst", "" }) {
+        QElapsedTimer t;
+        t.start();
+        const QStringList top = fuzzyTopK(cands, q, 50);
+        worst = qMax(worst, t.nsecsElapsed());
+        std::printf("smoke: fuzzy \"%s\": %d hits in %.2f ms\n", q, int(top.size()), t.nsecsElapsed() / 1e6);
+    }
+    return worst <= 16000000 ? 0 : 1;
+}
+CPP
+g++ $FLAGS -O2 -I. "$T/fuzzy_timing.cpp" -o "$T/bin/fuzzy_timing" `qt Qt6Core`
+"$T/bin/fuzzy_timing" || fail "fuzzy top-k over 100k candidates took longer than 16 ms"
+
+echo "smoke: ok"
@@ -3,7 +3,12 @@
 #include <QLineEdit>
 #include <QSizePolicy>
 #include <QDir>
+#include <QCompleter>
+#include <QStringListModel>
+#include <QAbstractItemView>
+#include <QTimer>
 #include <functional>
+#include "pathindex.h"
 
 class Breadcrumbs : public QToolBar {
 public:
@@ -15,19 +20,58 @@ public:
         edit->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
         addWidget(edit);
 
-        QObject::connect(edit, &QLineEdit::returnPressed, this, [this]{
-            if (onPathChosen) onPathChosen(edit->text());
-        });
+        QObject::connect(edit, &QLineEdit::returnPressed, this, [this]{ choose(); });
     }
 
     void setOnPathChosen(std::function<void(const QString&)> cb) { onPathChosen = std::move(cb); }
     QLineEdit* editField() const { return edit; }
 
+    // Fuzzy completion from `idx`. Results arrive asynchronously, so typing never waits on the filesystem.
+    void setCompletionIndex(PathIndex *idx) {
+        index = idx;
+        matches = new QStringListModel(this);
+        completer = new QCompleter(matches, this);
+        completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+        completer->setWidget(edit);
+
+        // Listings that arrive later re-run the query; once the popup has been dismissed,
+        // those refreshes must not pop it open again
+        QObject::connect(edit, &QLineEdit::textEdited, this, [this](const QString &t){
+            popupOpened = false;
+            index->match(t, this, [this](const QStringList &paths){
+                if (popupOpened && !completer->popup()->isVisible()) { index->forget(this); return; }
+                matches->setStringList(paths);
+                if (paths.isEmpty()) completer->popup()->hide();
+                else if (edit->hasFocus()) { completer->complete(); popupOpened = true; }
+            });
+        });
+        // Enter on a popup entry also reaches the line edit as returnPressed right after this;
+        // a mouse click does not, so navigate from here only if that didn't happen
+        QObject::connect(completer, QOverload<const QString&>::of(&QCompleter::activated), this, [this](const QString &p){
+            edit->setText(p);
+            popupChoice = true;
+            QTimer::singleShot(0, this, [this]{ if (popupChoice) choose(); });
+        });
+    }
+
     void setPath(const QString &path) {
+        if (index) index->forget(this);
         edit->setText(QDir::cleanPath(path));
     }
 
 private:
     QLineEdit *edit{};
+    PathIndex *index{};
+    QCompleter *completer{};
+    QStringListModel *matches{};
+    bool popupChoice = false;     // popup entry picked, navigation not done yet
+    bool popupOpened = false;     // the popup was shown for the text being typed
     std::function<void(const QString&)> onPathChosen;
+
+    void choose() {
+        popupChoice = false;
+        if (index) index->forget(this);
+        if (completer) completer->popup()->hide();
+        if (onPathChosen) onPathChosen(edit->text());
+    }
 };
@@ -0,0 +1,343 @@
+#pragma once
+#include <QWidget>
+#include <QObject>
+#include <QImage>
+#include <QPainter>
+#include <QDir>
+#include <QFileInfo>
+#include <QTimer>
+#include <QEvent>
+#include <QHelpEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QToolTip>
+#include <QFontMetrics>
+#include <QVector>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "fscore.h"
+
+// ---- Usage view: squarified treemap over a UsageTree (fscore.h) ----
+
+// One folder drawn at one size; only rebuilt when something at or below it changed
+struct UsageLayout {
+    QSize size;                       // tile size that `order`/`rects` were computed for
+    bool dirty = true;
+    std::vector<UsageNode*> order;    // children with size > 0, largest first
+    std::vector<QRect> rects;         // tile-local child rects, parallel to `order`
+    QImage image;
+};
+
+// Render cache of one folder. A folder is drawn both inside its parent and, once zoomed into,
+// at full view size; each size keeps its own layout so zooming back out still hit-tests right.
+struct UsageTile {
+    static constexpr size_t kMaxLayouts = 3;   // old sizes after window resizes are dropped
+    std::vector<UsageLayout> layouts;
+
+    UsageLayout *find(const QSize &sz) {
+        for (UsageLayout &l : layouts) if (l.size == sz) return &l;
+        return nullptr;
+    }
+    const UsageLayout *find(const QSize &sz) const {
+        for (const UsageLayout &l : layouts) if (l.size == sz) return &l;
+        return nullptr;
+    }
+    UsageLayout &at(const QSize &sz) {
+        if (UsageLayout *l = find(sz)) return *l;
+        if (layouts.size() >= kMaxLayouts) layouts.erase(layouts.begin());
+        layouts.push_back(UsageLayout());
+        layouts.back().size = sz;
+        return layouts.back();
+    }
+};
+
+// Squarified treemap (Bruls, Huizing & van Wijk). `sizes` must be sorted largest first.
+inline std::vector<QRectF> squarify(const std::vector<qint64> &sizes, QRectF r) {
+    std::vector<QRectF> out(sizes.size());
+    double total = 0;
+    for (qint64 s : sizes) total += double(s);
+    if (total <= 0 || r.width() <= 0 || r.height() <= 0) return out;
+    const double scale = r.width() * r.height() / total;
+
+    // Worst aspect ratio of a row holding area `sum` (largest item `big`, smallest `small`) along `side`
+    auto worst = [](double sum, double big, double small, double side) {
+        const double s2 = sum * sum, w2 = side * side;
+        return std::max(w2 * big / s2, s2 / (w2 * small));
+    };
+
+    size_t i = 0;
+    while (i < sizes.size()) {
+        const double side = std::min(r.width(), r.height());
+        const double big = double(sizes[i]) * scale;
+        double rowSum = big;
+        double best = worst(rowSum, big, big, side);
+        size_t j = i + 1;
+        for (; j < sizes.size(); ++j) {
+            const double a = double(sizes[j]) * scale;
+            const double next = worst(rowSum + a, big, a, side);
+            if (next > best) break;
+            rowSum += a;
+            best = next;
+        }
+
+        const double thick = rowSum / side;
+        double offset = 0;
+        const bool vertical = r.width() >= r.height();   // lay the row as a column on the left
+        for (size_t k = i; k < j; ++k) {
+            const double len = double(sizes[k]) * scale / thick;
+            out[k] = vertical ? QRectF(r.left(), r.top() + offset, thick, len)
+                              : QRectF(r.left() + offset, r.top(), len, thick);
+            offset += len;
+        }
+        if (vertical) r.setLeft(r.left() + thick);
+        else          r.setTop(r.top() + thick);
+        i = j;
+    }
+    return out;
+}
+
+class UsageMapView : public QWidget {
+public:
+    explicit UsageMapView(const QString &rootPath, QWidget *parent=nullptr)
+        : QWidget(parent), tree(rootPath) {
+        viewRoot = tree.root();
+
+        setMouseTracking(true);
+        setFocusPolicy(Qt::StrongFocus);
+        setAttribute(Qt::WA_OpaquePaintEvent);
+
+        // Coalesce scan results: repaint at most ~10x per second while the scan runs
+        refresh.setSingleShot(true);
+        refresh.setInterval(100);
+        QObject::connect(&refresh, &QTimer::timeout, this, [this]{
+            update();
+            if (onStatus && isVisible()) onStatus(QString("Scanning… %1 in %2 files, %3 folders queued")
+                                   .arg(humanSize(tree.root()->size)).arg(tree.files()).arg(tree.pendingDirs()));
+        });
+
+        // Only the chain from the listed folder up to the root needs a new layout
+        tree.setOnChanged([this](UsageNode *dir){
+            for (UsageNode *n = dir; n; n = n->parent) {
+                auto it = tiles.find(n);
+                if (it != tiles.end())
+                    for (UsageLayout &l : it->second.layouts) l.dirty = true;
+            }
+            if (!pendingPath.isEmpty()) showPath(pendingPath);
+            if (!refresh.isActive()) refresh.start();
+        });
+        tree.setOnFinished([this]{
+            refresh.stop();
+            update();
+            if (onStatus && isVisible()) onStatus(QString("Scan complete: %1 in %2 files")
+                                   .arg(humanSize(tree.root()->size)).arg(tree.files()));
+        });
+        tree.start();
+    }
+
+    void setOnZoom(std::function<void(const QString&)> cb) { onZoom = std::move(cb); }
+    void setOnOpenFile(std::function<void(const QString&)> cb) { onOpenFile = std::move(cb); }
+    void setOnStatus(std::function<void(const QString&)> cb) { onStatus = std::move(cb); }
+
+    // Whether `path` lies inside this scan, so the view can be reused instead of rescanning
+    bool covers(const QString &path) const {
+        const QString r = tree.root()->path();
+        return path == r || path.startsWith(r.endsWith('/') ? r : r + "/");
+    }
+
+    // Zoom to `path` (inside the scan). Folders not listed yet are zoomed to once they arrive.
+    void showPath(const QString &path) {
+        bool exact = false;
+        UsageNode *n = nodeFor(path, exact);
+        pendingPath = exact ? QString() : path;
+        if (n != viewRoot) { viewRoot = n; update(); }
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter p(this);
+        if (viewRoot->size == 0) {
+            p.fillRect(rect(), QColor(30, 30, 30));
+            p.setPen(Qt::white);
+            p.drawText(rect(), Qt::AlignCenter, tree.finished() ? "Empty" : "Scanning…");
+            return;
+        }
+        p.drawImage(0, 0, tileFor(viewRoot, size()));
+    }
+
+    bool event(QEvent *e) override {
+        if (e->type() == QEvent::ToolTip) {
+            auto *he = static_cast<QHelpEvent*>(e);
+            if (UsageNode *n = nodeAt(he->pos()))
+                QToolTip::showText(he->globalPos(), n->path() + "\n" + humanSize(n->size), this);
+            else
+                QToolTip::hideText();
+            return true;
+        }
+        return QWidget::event(e);
+    }
+
+    void mouseDoubleClickEvent(QMouseEvent *e) override {
+        if (e->button() != Qt::LeftButton) return;
+        UsageNode *n = nodeAt(e->position().toPoint());
+        if (!n) return;
+        if (n->isDir) zoomTo(n);
+        else if (onOpenFile) onOpenFile(n->path());
+    }
+
+    void mousePressEvent(QMouseEvent *e) override {
+        if (e->button() == Qt::RightButton || e->button() == Qt::BackButton) zoomOut();
+        else QWidget::mousePressEvent(e);
+    }
+
+    void keyPressEvent(QKeyEvent *e) override {
+        if (e->key() == Qt::Key_Backspace || e->key() == Qt::Key_Escape) zoomOut();
+        else QWidget::keyPressEvent(e);
+    }
+
+private:
+    static constexpr int kHeader = 14;    // name strip on top of each folder tile
+    static constexpr int kMinTile = 12;   // smaller folders are drawn flat, without their contents
+
+    UsageTree tree;
+    std::unordered_map<const UsageNode*, UsageTile> tiles;   // node-based: references survive inserts
+    UsageNode *viewRoot{};
+    QString pendingPath;          // showPath() target whose folders haven't been listed yet
+    QTimer refresh;
+
+    std::function<void(const QString&)> onZoom, onOpenFile, onStatus;
+
+    // Deepest listed folder on the way to `path`; `exact` tells whether it is `path` itself
+    UsageNode *nodeFor(const QString &path, bool &exact) const {
+        UsageNode *n = tree.root();
+        const QStringList parts = path.mid(n->path().size()).split('/', Qt::SkipEmptyParts);
+        for (const QString &part : parts) {
+            UsageNode *next = nullptr;
+            for (const auto &c : n->children)
+                if (c->isDir && c->name == part) { next = c.get(); break; }
+            if (!next) { exact = false; return n; }
+            n = next;
+        }
+        exact = true;
+        return n;
+    }
+
+    void zoomTo(UsageNode *n) {
+        if (!n || n == viewRoot) return;
+        pendingPath.clear();
+        viewRoot = n;
+        if (onZoom) onZoom(n->path());
+        update();
+    }
+
+    void zoomOut() {
+        if (viewRoot->parent) zoomTo(viewRoot->parent);
+    }
+
+    static QColor dirColor(const UsageNode *n) {
+        return QColor::fromHsv((210 + n->depth * 37) % 360, 70, qMax(60, 120 - n->depth * 8));
+    }
+
+    static QColor fileColor(const UsageNode *n) {
+        const QString suffix = QFileInfo(n->name).suffix().toLower();
+        if (suffix.isEmpty()) return QColor(150, 150, 150);
+        return QColor::fromHsv(int(qHash(suffix) % 360), 120, 200);
+    }
+
+    static QRect snap(const QRectF &r) {
+        return QRect(QPoint(qRound(r.left()), qRound(r.top())),
+                     QPoint(qRound(r.right()) - 1, qRound(r.bottom()) - 1));
+    }
+
+    static int headerFor(const QSize &sz) {
+        return (sz.height() >= 2 * kHeader && sz.width() >= 40) ? kHeader : 0;
+    }
+
+    void layoutNode(const UsageNode *n, UsageLayout &t, const QSize &sz) {
+        t.order.clear();
+        for (auto &c : n->children)
+            if (c->size > 0) t.order.push_back(c.get());
+        std::sort(t.order.begin(), t.order.end(),
+                  [](const UsageNode *a, const UsageNode *b){ return a->size > b->size; });
+
+        std::vector<qint64> sizes;
+        sizes.reserve(t.order.size());
+        for (const UsageNode *c : t.order) sizes.push_back(c->size);
+
+        const int header = headerFor(sz);
+        const QRectF inner(1, header + 1, sz.width() - 2, sz.height() - header - 2);
+        const std::vector<QRectF> laid = squarify(sizes, inner);
+        t.rects.resize(laid.size());
+        for (size_t i = 0; i < laid.size(); ++i) t.rects[i] = snap(laid[i]);
+    }
+
+    // Cached tile of a folder at `sz`; clean subtrees are reused as-is, so zooming back out is a blit
+    const QImage &tileFor(const UsageNode *n, const QSize &sz) {
+        UsageLayout &t = tiles[n].at(sz);   // children recurse into other nodes' tiles only
+        if (!t.dirty && !t.image.isNull()) return t.image;
+        layoutNode(n, t, sz);
+
+        QImage img(sz, QImage::Format_ARGB32_Premultiplied);
+        img.fill(dirColor(n));
+        QPainter p(&img);
+        p.setPen(QColor(20, 20, 20));
+        p.drawRect(img.rect().adjusted(0, 0, -1, -1));
+
+        if (const int header = headerFor(sz)) {
+            const QString label = QString("%1 — %2").arg(n->parent ? n->name : n->path(),
+                                                        humanSize(n->size));
+            p.setPen(Qt::white);
+            const QRect strip(4, 1, sz.width() - 8, header);
+            p.drawText(strip, Qt::AlignVCenter | Qt::AlignLeft,
+                       p.fontMetrics().elidedText(label, Qt::ElideMiddle, strip.width()));
+        }
+
+        for (size_t i = 0; i < t.order.size(); ++i) {
+            const UsageNode *c = t.order[i];
+            const QRect &r = t.rects[i];
+            if (r.width() < 1 || r.height() < 1) continue;
+            if (c->isDir && r.width() >= kMinTile && r.height() >= kMinTile) {
+                p.drawImage(r.topLeft(), tileFor(c, r.size()));
+                continue;
+            }
+            p.fillRect(r, c->isDir ? dirColor(c) : fileColor(c));
+            if (r.width() > 2 && r.height() > 2) {
+                p.setPen(QColor(20, 20, 20, 160));
+                p.drawRect(r.adjusted(0, 0, -1, -1));
+            }
+        }
+        p.end();
+
+        t.image = img;
+        t.dirty = false;
+        return t.image;
+    }
+
+    // Deepest node under `pos`, following the layouts the last paint used
+    UsageNode *nodeAt(const QPoint &pos) const {
+        UsageNode *n = viewRoot;
+        QPoint p = pos;
+        QSize sz = size();
+        while (n->isDir) {
+            const auto it = tiles.find(n);
+            const UsageLayout *l = it == tiles.end() ? nullptr : it->second.find(sz);
+            if (!l) break;
+            const UsageLayout &t = *l;
+            UsageNode *hit = nullptr;
+            for (size_t i = 0; i < t.order.size(); ++i) {
+                const QRect &r = t.rects[i];
+                if (!r.contains(p)) continue;
+                hit = t.order[i];
+                p -= r.topLeft();
+                sz = r.size();
+                break;
+            }
+            if (!hit) return n;
+            if (!hit->isDir || sz.width() < kMinTile || sz.height() < kMinTile) return hit;
+            n = hit;
+        }
+        return n;
+    }
+};
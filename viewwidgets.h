@@ -7,6 +7,7 @@
 #include <QVBoxLayout>
 #include <QHeaderView>
 #include <QPalette>
+#include <QStatusBar>
 
 // Out-of-class definitions for ColFM view builders
 
@@ -16,6 +17,7 @@ inline QWidget* ColFM::buildTreeWidget(const QModelIndex &root) {
     view->setRootIndex(root);
     view->setHeaderHidden(false);
     view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->setSelectionMode(QAbstractItemView::ExtendedSelection);
     view->setAlternatingRowColors(true);
     view->setIconSize(kIconSize);
     view->setItemDelegate(new FixedIconDelegate(view));
@@ -30,11 +32,13 @@ inline QWidget* ColFM::buildTreeWidget(const QModelIndex &root) {
             view->setRootIndex(idx);
             currentRoot = idx;
             if (crumbs) crumbs->setPath(model->filePath(idx));
+            if (paths) paths->visit(model->filePath(idx));
         } else {
             openFile(idx);
         }
     });
 
+    currentView = view;
     return view;
 }
 
@@ -48,6 +52,7 @@ inline QWidget* ColFM::buildColumnWidget(const QModelIndex &root) {
     cv->setIconSize(kIconSize);
     cv->setResizeGripsVisible(true);
     cv->setSelectionBehavior(QAbstractItemView::SelectRows);
+    cv->setSelectionMode(QAbstractItemView::ExtendedSelection);
     cv->setColumnWidths({400,400,400});
     cv->setItemDelegate(new FixedIconDelegate(cv));
 
@@ -65,6 +70,7 @@ inline QWidget* ColFM::buildColumnWidget(const QModelIndex &root) {
             cv->setRootIndex(idx);
             currentRoot = idx;
             if (crumbs) crumbs->setPath(model->filePath(idx));
+            if (paths) paths->visit(model->filePath(idx));
         } else {
             openFile(idx);
         }
@@ -85,6 +91,7 @@ inline QWidget* ColFM::buildColumnWidget(const QModelIndex &root) {
     splitter->addWidget(previewPane);
     splitter->setStretchFactor(0, 3);
     splitter->setStretchFactor(1, 2);
+    currentView = cv;
     return splitter;
 }
 
@@ -93,6 +100,7 @@ inline QWidget* ColFM::buildIconWidget(const QModelIndex &root) {
     view->setModel(model);
     view->setRootIndex(root);
     view->setViewMode(QListView::IconMode);
+    view->setSelectionMode(QAbstractItemView::ExtendedSelection);
     view->setIconSize(kIconSize);
     view->setItemDelegate(new FixedIconDelegate(view));
     view->setGridSize(QSize(64,64));
@@ -107,10 +115,38 @@ inline QWidget* ColFM::buildIconWidget(const QModelIndex &root) {
             view->setRootIndex(idx);
             currentRoot = idx;
             if (crumbs) crumbs->setPath(model->filePath(idx));
+            if (paths) paths->visit(model->filePath(idx));
         } else {
             openFile(idx);
         }
     });
 
+    currentView = view;
     return view;
 }
+
+inline QWidget* ColFM::buildUsageWidget(const QModelIndex &root) {
+    const QString path = model->filePath(root);
+    currentView = nullptr; // no item selection in the map
+
+    // Folders inside the existing scan are just a zoom; anything else starts a new scan
+    if (usageView && !usageView->covers(path)) {
+        usageView->deleteLater();
+        usageView = nullptr;
+    }
+    if (!usageView) {
+        usageView = new UsageMapView(path);
+
+        // Zooming into a folder makes it the current folder for the other views and Go Up
+        usageView->setOnZoom([this](const QString &p){
+            currentRoot = model->index(p);
+            if (crumbs) crumbs->setPath(p);
+            if (paths) paths->visit(p);
+        });
+        usageView->setOnOpenFile([this](const QString &p){ openFile(model->index(p)); });
+        usageView->setOnStatus([this](const QString &msg){ statusBar()->showMessage(msg); });
+    }
+    usageView->showPath(path);
+    usageView->show();
+    return usageView;
+}